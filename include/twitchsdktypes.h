@@ -92,7 +92,7 @@ typedef enum
 #define TTV_MAX_BITRATE 3500
 #define TTV_MIN_FPS		10
 #define TTV_MAX_FPS		60
-#define TTV_MAX_WIDTH	1920				/* Width and height must be multiples of 16 */
+#define TTV_MAX_WIDTH	1920				/* Width must be a multiple of 32 and height a multiple of 16 */
 #define TTV_MAX_HEIGHT	1200
 
 /**
@@ -11,6 +11,8 @@
 #include "boost/chrono.hpp"
 #pragma warning (pop)
 #include <fstream>
+#include <vector>
+#include <algorithm>
 
 namespace po = boost::program_options;
 std::string gClientId = "<client id here>";
@@ -22,6 +24,27 @@ uint64_t gRTMPState;
 
 boost::chrono::time_point<boost::chrono::steady_clock> gStartTime;
 
+// The outcome of testing a single ingest server
+struct IngestResult
+{
+	std::string serverName;
+	bool connected;					// Whether or not TTV_Start succeeded
+	TTV_ErrorCode startError;		// The error returned by TTV_Start if it failed
+	boost::chrono::milliseconds connectionTime;
+	float bitrateKbps;
+};
+
+// Servers which connected come first, ordered from the highest to the lowest bitrate
+bool CompareIngestResults(const IngestResult& a, const IngestResult& b)
+{
+	if (a.connected != b.connected)
+	{
+		return a.connected;
+	}
+
+	return a.bitrateKbps > b.bitrateKbps;
+}
+
 void* AllocCallback (size_t size, size_t alignment)
 {
 	return _aligned_malloc(size, alignment);
@@ -251,6 +274,8 @@ int _tmain(int argc, _TCHAR* argv[])
 	videoParams.outputWidth = width;
 	videoParams.outputHeight = height;
 	videoParams.pixelFormat = TTV_PF_BGRA;
+	videoParams.disableAdaptiveBitrate = true;
+	videoParams.verticalFlip = false;
 
 	TTV_GetDefaultParams(&videoParams);
 
@@ -266,23 +291,43 @@ int _tmain(int argc, _TCHAR* argv[])
 
 	auto testDuration = boost::chrono::seconds(variableMap["duration"].as<unsigned int>());
 
+	std::vector<IngestResult> results;
+
 	for (auto i = 0U;TTV_SUCCEEDED(ret) && i<ingestList.ingestCount; i++)
 	{
 		std::cout << "- Testing " << ingestList.ingestList[i].serverName << '\n';		
 
+		IngestResult result;
+		result.serverName = ingestList.ingestList[i].serverName;
+		result.connected = false;
+		result.startError = TTV_EC_SUCCESS;
+		result.connectionTime = boost::chrono::milliseconds(0);
+		result.bitrateKbps = 0.0f;
+
 		gTotalSent = 0;
 		gRTMPState = 0;
 
 		gStartTime = boost::chrono::steady_clock::now();
 
-		ret = TTV_Start(&videoParams, &audioParams, &ingestList.ingestList[i], 0, nullptr, nullptr);
-		ASSERT_ON_ERROR(ret);
+		// Start in bandwidth test mode so the measurement reflects the connection rather than the encoder.  A server which
+		// can't be reached is recorded as failed and the remaining servers are still tested.
+		TTV_ErrorCode startRet = TTV_Start(&videoParams, &audioParams, &ingestList.ingestList[i], TTV_Start_BandwidthTest, nullptr, nullptr);
+		if (TTV_FAILED(startRet))
+		{
+			result.startError = startRet;
+			std::cout << "\t- Failed to start (" << TTV_ErrorToString(startRet) << ")\n" << std::endl;
+			results.push_back(result);
+			continue;
+		}
 
 		auto elapsedTime = boost::chrono::steady_clock::now() - gStartTime;
 
 		auto conectionTime = boost::chrono::duration_cast<boost::chrono::milliseconds>(elapsedTime);
 		gStartTime = boost::chrono::steady_clock::now();
 
+		result.connected = true;
+		result.connectionTime = conectionTime;
+
 		auto lastTotalSent = gTotalSent;
 
 		bool twiddle = true;
@@ -292,6 +337,7 @@ int _tmain(int argc, _TCHAR* argv[])
 			twiddle = !twiddle;
 			
 			TTV_PollStats();
+			boost::thread::yield();
 			elapsedTime = boost::chrono::steady_clock::now() - gStartTime;
 
 			if (lastTotalSent != gTotalSent)
@@ -300,9 +346,12 @@ int _tmain(int argc, _TCHAR* argv[])
 				float bitrate = static_cast<float>(gTotalSent * 8) / static_cast<float>(elapsedMilliseconds.count());
 				std::cout << "\t- RTMP Connected (" << conectionTime.count() << "ms) " << bitrate << "Kbps   \n";
 				lastTotalSent = gTotalSent;
+				result.bitrateKbps = bitrate;
 			}
 		} while (elapsedTime < testDuration);
 
+		results.push_back(result);
+
 		if (TTV_SUCCEEDED(ret))
 		{
 			ret = TTV_Stop(nullptr, nullptr);
@@ -313,6 +362,24 @@ int _tmain(int argc, _TCHAR* argv[])
 		std::cout << std::endl;
 	}
 
+	// Rank the servers from the highest to the lowest sustained bitrate with the ones that failed to start last
+	std::stable_sort(results.begin(), results.end(), CompareIngestResults);
+
+	std::cout << "- Ranked ingest servers\n";
+	for (size_t i = 0; i < results.size(); ++i)
+	{
+		std::cout << "\t" << (i + 1) << ". " << results[i].serverName << " - ";
+		if (results[i].connected)
+		{
+			std::cout << results[i].bitrateKbps << "Kbps (connected in " << results[i].connectionTime.count() << "ms)\n";
+		}
+		else
+		{
+			std::cout << "failed to start (" << TTV_ErrorToString(results[i].startError) << ")\n";
+		}
+	}
+	std::cout << std::endl;
+
 	if (TTV_SUCCEEDED(ret))
 	{
 		ret = TTV_FreeIngestList(&ingestList);
@@ -7,6 +7,11 @@
 #include "streaming.h"
 #include <vector>
 #include <algorithm>
+#include <mutex>
+
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
 
 bool gSdkInitialized = false;			// Whether or not TTV_Init has been called.
 StreamState gStreamState = SS_Uninitialized;	// The current state of streaming.
@@ -23,11 +28,99 @@ TTV_UserInfo gUserInfo;					// Profile information about the local user.
 TTV_StreamInfo gStreamInfo;				// Information about the stream the user is streaming on.
 TTV_IngestServer gIngestServer;			// The ingest server to use.
 
-std::vector<unsigned char*> gFreeBufferList;	// The list of free buffers.  The app needs to allocate exactly 3.
+const unsigned int kNumCaptureBuffers = 3;		// The number of capture buffers to allocate.
+const size_t kCaptureBufferAlignment = 16;		// The SDK requires 16-byte aligned frame buffers (see TTV_EC_ALIGN16_REQUIRED).
+
+std::vector<unsigned char*> gFreeBufferList;	// The list of free buffers.  Guarded by gFreeBufferMutex.
 std::vector<unsigned char*> gCaptureBuffers;	// The list of all buffers.
+std::mutex gFreeBufferMutex;					// Guards gFreeBufferList since buffers are unlocked from an SDK thread.
+unsigned int gStarvedCaptureCount = 0;			// The number of captures skipped because no free buffer was available.
+unsigned int gDroppedFrameCount = 0;			// The number of frames dropped because the SDK's frame queue was full.
+
+const uint64_t kMinReconnectDelayMs = 1000;		// The delay before the first attempt to restart a dropped stream.
+const uint64_t kMaxReconnectDelayMs = 30000;	// The longest delay between attempts to restart a dropped stream.
+
+unsigned int gReconnectAttempts = 0;			// The number of restart attempts made for the current outage, 0 if not reconnecting.
+uint64_t gNextReconnectTimeMs = 0;				// The time at which the next restart may be attempted.
+uint64_t gOutageStartTimeMs = 0;				// The time at which the connection to the ingest server was lost.
+unsigned int gReconnectCount = 0;				// The number of times the stream was successfully restarted after a dropped connection.
+uint64_t gLastOutageDurationMs = 0;				// The length of the most recent outage in milliseconds.
+
+const uint64_t kShutdownStopTimeoutMs = 3000;	// The longest ShutdownStreaming() waits for a pending stop before aborting it.
+
+uint64_t gStopStartTimeMs = 0;					// The time at which the pending TTV_Stop was requested.
+uint64_t gLastStopDurationMs = 0;				// The time the most recent TTV_Stop took to complete in milliseconds.
 
 // Forward declarations
 void ReportError(const char* format, ...);
+void ReturnFreeBuffer(unsigned char* pBuffer);
+bool AllocateCaptureBuffers(size_t bufferSize);
+void FreeCaptureBuffers();
+
+
+/**
+ * Returns a monotonic timestamp in milliseconds.  GetTickCount64 is used rather than std::chrono::steady_clock since the 
+ * VS2012 runtime implements steady_clock with the wall clock, which can jump backwards.
+ */
+static uint64_t GetTimeMs()
+{
+	return GetTickCount64();
+}
+
+
+/**
+ * Determines whether the error means the connection to the ingest server was lost, in which case streaming can be restarted.
+ */
+static bool IsConnectionError(TTV_ErrorCode err)
+{
+	switch (err)
+	{
+		case TTV_EC_RTMP_UNABLE_TO_SEND_DATA:
+		case TTV_EC_RTMP_TIMEOUT:
+		case TTV_EC_SOCKET_GETADDRINFO_FAILED:
+		case TTV_EC_SOCKET_CONNECT_FAILED:
+		case TTV_EC_SOCKET_SEND_ERROR:
+		case TTV_EC_SOCKET_RECV_ERROR:
+		case TTV_EC_SOCKET_ENETDOWN:
+		case TTV_EC_SOCKET_ENETUNREACH:
+		case TTV_EC_SOCKET_ENETRESET:
+		case TTV_EC_SOCKET_ECONNABORTED:
+		case TTV_EC_SOCKET_ECONNRESET:
+		case TTV_EC_SOCKET_ENOTCONN:
+		case TTV_EC_SOCKET_ESHUTDOWN:
+		case TTV_EC_SOCKET_ETIMEDOUT:
+		case TTV_EC_SOCKET_ECONNREFUSED:
+		case TTV_EC_SOCKET_EHOSTDOWN:
+		case TTV_EC_SOCKET_EHOSTUNREACH:
+			return true;
+		default:
+			return false;
+	}
+}
+
+
+/**
+ * Schedules the next attempt to restart the stream after the connection was lost.  The delay doubles with each failed 
+ * attempt up to kMaxReconnectDelayMs.
+ */
+static void ScheduleReconnect()
+{
+	uint64_t now = GetTimeMs();
+
+	if (gReconnectAttempts == 0)
+	{
+		gOutageStartTimeMs = now;
+	}
+
+	uint64_t delay = kMinReconnectDelayMs;
+	for (unsigned int i=0; i<gReconnectAttempts && delay < kMaxReconnectDelayMs; ++i)
+	{
+		delay *= 2;
+	}
+
+	++gReconnectAttempts;
+	gNextReconnectTimeMs = now + std::min(delay, kMaxReconnectDelayMs);
+}
 
 
 #pragma region Callbacks
@@ -146,7 +239,30 @@ void FrameUnlockCallback(const uint8_t* buffer, void* /*userData*/)
 	unsigned char* p = const_cast<unsigned char*>(buffer);
 
 	// Put back on the free list
-	gFreeBufferList.push_back(p);
+	ReturnFreeBuffer(p);
+}
+
+/**
+ * The callback that is called when the SDK has finished stopping the stream.  The SDK no longer holds any of the capture 
+ * buffers so they can be released.
+ */
+void StopCallback(TTV_ErrorCode result, void* /*userData*/)
+{
+	gLastStopDurationMs = GetTimeMs() - gStopStartTimeMs;
+
+	FreeCaptureBuffers();
+
+	// The state may have been changed while stopping (e.g. due to an unrecoverable error or shutdown)
+	if (gStreamState == SS_Stopping)
+	{
+		gStreamState = SS_ReadyToStream;
+	}
+
+	if ( TTV_FAILED(result) && result != TTV_EC_REQUEST_ABORTED )
+	{
+		const char* err = TTV_ErrorToString(result);
+		ReportError("StopCallback got failure: %s\n", err);
+	}
 }
 
 #pragma endregion
@@ -176,11 +292,14 @@ void InitializeStreaming(const std::string& username, const std::string& passwor
 		case SS_FoundIngestServer:		
 		case SS_Streaming:
 		case SS_Paused:		
+		case SS_Stopping:
 			return;
 		default:
 			break;
 	}
 
+	CancelReconnect();
+
 	gUserName = username;
 	gPassword = password;
 	gClientId = clientId;
@@ -250,6 +369,7 @@ void StartStreaming(unsigned int outputWidth, unsigned int outputHeight, unsigne
 		case SS_FoundIngestServer:		
 		case SS_Streaming:
 		case SS_Paused:
+		case SS_Stopping:
 			return;
 
 		// Ready to stream
@@ -277,9 +397,28 @@ void StartStreaming(unsigned int outputWidth, unsigned int outputHeight, unsigne
 	audioParams.enablePlaybackCapture = true;
 	audioParams.enablePassthroughAudio = false;
 
+	// Allocate the buffers to use as the capture destination while streaming.
+	// These buffers are passed to the SDK.
+	if (!AllocateCaptureBuffers(outputWidth*outputHeight*4))
+	{
+		ReportError("Failed to allocate the capture buffers\n");
+		return;
+	}
+
 	TTV_ErrorCode ret = TTV_Start(&videoParams, &audioParams, &gIngestServer, 0, nullptr, nullptr);
 	if ( TTV_FAILED(ret) )
 	{
+		FreeCaptureBuffers();
+
+		// Still can't reach the ingest server so back off and try again later
+		if (gReconnectAttempts > 0 && IsConnectionError(ret))
+		{
+			ScheduleReconnect();
+			return;
+		}
+
+		gReconnectAttempts = 0;
+
 		const char* err = TTV_ErrorToString(ret);
 		ReportError("Error while starting to stream: %s\n", err);
 		return;
@@ -288,13 +427,12 @@ void StartStreaming(unsigned int outputWidth, unsigned int outputHeight, unsigne
 	// Now streaming
 	gStreamState = SS_Streaming;
 
-	// Allocate exactly 3 buffers to use as the capture destination while streaming.
-	// These buffers are passed to the SDK.
-	for (unsigned int i=0; i<3; ++i)
+	// Record how long the stream was down if this was a restart after a dropped connection
+	if (gReconnectAttempts > 0)
 	{
-		unsigned char* pBuffer = new unsigned char[outputWidth*outputHeight*4];
-		gCaptureBuffers.push_back(pBuffer);
-		gFreeBufferList.push_back(pBuffer);
+		gLastOutageDurationMs = GetTimeMs() - gOutageStartTimeMs;
+		++gReconnectCount;
+		gReconnectAttempts = 0;
 	}
 }
 
@@ -309,13 +447,16 @@ const std::string& GetUsername()
 
 
 /**
- * Grabs the next available buffer from the free list.  There should always be one available.
+ * Grabs the next available buffer from the free list.  If the SDK still holds all of the buffers then nullptr is returned 
+ * and the capture should be skipped.  This is counted and can be retrieved with GetStarvedCaptureCount().
  */
 unsigned char* GetNextFreeBuffer()
 {
+	std::lock_guard<std::mutex> lock(gFreeBufferMutex);
+
 	if (gFreeBufferList.size() == 0)
 	{
-		ReportError("Out of free buffers, this should never happen\n");
+		++gStarvedCaptureCount;
 		return nullptr;
 	}
 
@@ -326,23 +467,122 @@ unsigned char* GetNextFreeBuffer()
 }
 
 
+/**
+ * Puts a buffer back on the free list.  Each buffer must be returned exactly once per GetNextFreeBuffer(), either by 
+ * FrameUnlockCallback() or by SubmitFrame() when the SDK refused it.  Buffers which have already been freed are ignored.
+ */
+void ReturnFreeBuffer(unsigned char* pBuffer)
+{
+	std::lock_guard<std::mutex> lock(gFreeBufferMutex);
+
+	if (std::find(gCaptureBuffers.begin(), gCaptureBuffers.end(), pBuffer) != gCaptureBuffers.end())
+	{
+		gFreeBufferList.push_back(pBuffer);
+	}
+}
+
+
+/**
+ * Allocates the full pool of capture buffers.  If any allocation fails the pool is released and false is returned so 
+ * streaming never starts with fewer buffers than expected.
+ */
+bool AllocateCaptureBuffers(size_t bufferSize)
+{
+	std::lock_guard<std::mutex> lock(gFreeBufferMutex);
+
+	gStarvedCaptureCount = 0;
+	gDroppedFrameCount = 0;
+
+	for (unsigned int i=0; i<kNumCaptureBuffers; ++i)
+	{
+		unsigned char* pBuffer = static_cast<unsigned char*>( _aligned_malloc(bufferSize, kCaptureBufferAlignment) );
+		if (pBuffer == nullptr)
+		{
+			for (unsigned int j=0; j<gCaptureBuffers.size(); ++j)
+			{
+				_aligned_free(gCaptureBuffers[j]);
+			}
+			gFreeBufferList.clear();
+			gCaptureBuffers.clear();
+
+			return false;
+		}
+
+		gCaptureBuffers.push_back(pBuffer);
+		gFreeBufferList.push_back(pBuffer);
+	}
+
+	return true;
+}
+
+
+/**
+ * Frees all of the capture buffers.  This must only be called once the SDK no longer holds any of them.
+ */
+void FreeCaptureBuffers()
+{
+	std::lock_guard<std::mutex> lock(gFreeBufferMutex);
+
+	for (unsigned int i=0; i<gCaptureBuffers.size(); ++i)
+	{
+		_aligned_free(gCaptureBuffers[i]);
+	}
+	gFreeBufferList.clear();
+	gCaptureBuffers.clear();
+}
+
+
+/**
+ * Retrieves the number of captures which were skipped because all of the capture buffers were still held by the SDK.
+ */
+unsigned int GetStarvedCaptureCount()
+{
+	return gStarvedCaptureCount;
+}
+
+
+/**
+ * Retrieves the number of frames which were dropped because the SDK's frame queue was full.
+ */
+unsigned int GetDroppedFrameCount()
+{
+	return gDroppedFrameCount;
+}
+
+
 /**
  * Submits a frame to the stream.  The size of the buffer must be outputWidth*outputHeight*4 which was specified in the call to StartStreaming().
  */
 void SubmitFrame(unsigned char* pBgraFrame)
 {	
-	if (!IsStreaming())
+	if (!IsStreaming() || pBgraFrame == nullptr)
 	{
 		return;
 	}
 
 	TTV_ErrorCode ret = TTV_SubmitVideoFrame(pBgraFrame, FrameUnlockCallback, 0);
-	if ( TTV_FAILED(ret) )
+
+	// The encoder is momentarily behind so drop this frame and keep streaming.  When TTV_SubmitVideoFrame fails the SDK 
+	// has not locked the buffer and will never call FrameUnlockCallback for it, so it goes straight back on the free list.
+	if (ret == TTV_EC_FRAME_QUEUE_FULL)
+	{
+		++gDroppedFrameCount;
+		ReturnFreeBuffer(pBgraFrame);
+	}
+	else if ( TTV_FAILED(ret) )
 	{
 		// not streaming anymore
-		gStreamState = SS_Initialized;
 		StopStreaming();
 
+		// The connection to the ingest server was lost so restart the stream once the backoff delay has passed
+		if (IsConnectionError(ret))
+		{
+			ScheduleReconnect();
+			return;
+		}
+
+		gStreamState = SS_Initialized;
+
 		const char* err = TTV_ErrorToString(ret);
 		ReportError("Error while submitting frame to stream: %s\n", err);
 	}
@@ -387,14 +627,50 @@ bool IsStreaming()
 
 
 /**
- * Determines whether or not the SDK has been initialized properly and is ready to have StartStreaming() called.
+ * Determines whether or not the SDK has been initialized properly and is ready to have StartStreaming() called.  After the
+ * connection to the ingest server is lost this returns false until the next restart attempt is due.
  */
 bool IsReadyToStream()
 {
+	if (gReconnectAttempts > 0 && GetTimeMs() < gNextReconnectTimeMs)
+	{
+		return false;
+	}
+
 	return gStreamState == SS_ReadyToStream;
 }
 
 
+/**
+ * Retrieves the number of times the stream was restarted after the connection to the ingest server was lost.
+ */
+unsigned int GetReconnectCount()
+{
+	return gReconnectCount;
+}
+
+
+/**
+ * Retrieves the length in milliseconds of the most recent period the stream was down before being restarted.
+ */
+uint64_t GetLastOutageDurationMs()
+{
+	return gLastOutageDurationMs;
+}
+
+
+/**
+ * Abandons any pending restart after a dropped connection.  This should be called when the user chooses to stop streaming 
+ * so that a later manual start isn't counted as a reconnect.
+ */
+void CancelReconnect()
+{
+	gReconnectAttempts = 0;
+	gNextReconnectTimeMs = 0;
+	gOutageStartTimeMs = 0;
+}
+
+
 /**
  * Allows the callback functions to be called on the current thread.  This should be called periodically.
  */
@@ -439,6 +715,7 @@ void FlushStreamingEvents()
 		case SS_Uninitialized:		
 		case SS_Streaming:
 		case SS_Paused:
+		case SS_Stopping:
 		{
 			break;
 		}
@@ -451,7 +728,9 @@ void FlushStreamingEvents()
 
 
 /**
- * After StartStreaming() is called streaming will continue until this function is called.
+ * After StartStreaming() is called streaming will continue until this function is called.  The stop is asynchronous so 
+ * the game thread isn't blocked while the SDK flushes the encoder and waits on the network.  The state is SS_Stopping
+ * until the SDK has finished, at which point IsReadyToStream() will return true again.
  */
 void StopStreaming()
 {
@@ -461,22 +740,27 @@ void StopStreaming()
 	}
 
 	// No longer streaming
-	gStreamState = SS_ReadyToStream;
+	gStreamState = SS_Stopping;
+	gStopStartTimeMs = GetTimeMs();
 
-	TTV_ErrorCode ret = TTV_Stop(nullptr, nullptr);
+	TTV_ErrorCode ret = TTV_Stop(StopCallback, nullptr);
 	if ( TTV_FAILED(ret) )
 	{
+		gStreamState = SS_ReadyToStream;
+		FreeCaptureBuffers();
+
 		const char* err = TTV_ErrorToString(ret);
 		ReportError("Error while stopping the stream: %s\n", err);
 	}
+}
 
-	// Delete the capture buffers
-	for (unsigned int i=0; i<gCaptureBuffers.size(); ++i)
-	{
-		delete [] gCaptureBuffers[i];
-	}
-	gFreeBufferList.clear();
-	gCaptureBuffers.clear();
+
+/**
+ * Retrieves the time in milliseconds the most recent stop took from StopStreaming() until the SDK finished.
+ */
+uint64_t GetLastStopDurationMs()
+{
+	return gLastStopDurationMs;
 }
 
 
@@ -490,12 +774,42 @@ void ShutdownStreaming()
 		return;
 	}
 
-	StopStreaming();
+	// Stop synchronously so the broadcast is flushed and closed cleanly before the SDK goes away
+	if (IsStreaming())
+	{
+		TTV_ErrorCode ret = TTV_Stop(nullptr, nullptr);
+		if ( TTV_FAILED(ret) )
+		{
+			const char* err = TTV_ErrorToString(ret);
+			ReportError("Error while stopping the stream: %s\n", err);
+		}
+
+		gStreamState = SS_ReadyToStream;
+	}
+
+	// Give a stop started by StopStreaming() a chance to finish.  If it takes too long then TTV_Shutdown aborts it 
+	// and StopCallback is called with TTV_EC_REQUEST_ABORTED.
+	uint64_t deadline = GetTimeMs() + kShutdownStopTimeoutMs;
+	while (gStreamState == SS_Stopping && GetTimeMs() < deadline)
+	{
+		if ( TTV_FAILED(TTV_PollTasks()) )
+		{
+			break;
+		}
+
+		Sleep(10);
+	}
+
+	CancelReconnect();
 
 	gSdkInitialized = false;
 	gStreamState = SS_Uninitialized;
 
 	TTV_ErrorCode ret = TTV_Shutdown();
+
+	// The SDK no longer holds any buffers
+	FreeCaptureBuffers();
+
 	if ( TTV_FAILED(ret) )
 	{
 		const char* err = TTV_ErrorToString(ret);
@@ -226,7 +226,7 @@ bool CaptureFrame(int captureWidth, int captureHeight, unsigned char*& outBgraFr
 	if (gMainRenderTargetSurface == nullptr || 
 		captureWidth <= 0 || 
 		captureHeight <= 0 ||
-		captureWidth % 16 != 0 ||
+		captureWidth % 32 != 0 ||
 		captureHeight % 16 != 0)
 	{
 		return false;
@@ -27,8 +27,8 @@ IDirect3D9* gDirect3D = nullptr;							// The Direct3D instance.
 IDirect3DDevice9* gGraphicsDevice = nullptr;				// The graphics device.
 
 float gRenderFramesPerSecond = 60;							// The number of frames per second to render, 0 if no throttling.
-float gLastFrameTime = 0;									// The last time a frame was rendered.
-float gLastCaptureTime = 0;									// The timestamp of the last frame capture.
+double gLastFrameTime = 0;									// The last time a frame was rendered.
+double gLastCaptureTime = 0;									// The scheduled time of the last frame capture in milliseconds.
 
 // 360p widescreen is 640x360
 // 480p widescreen is about 853x480
@@ -66,35 +66,35 @@ LRESULT CALLBACK	WndProc(HWND, UINT, WPARAM, LPARAM);
 
 #pragma region Timer Functions
 
-float GetSystemClockFrequency()
+double GetSystemClockFrequency()
 {	
-	static float frequency = 0;
+	static double frequency = 0;
 	if (frequency == 0)
 	{
 		unsigned __int64 freq;
 		QueryPerformanceFrequency( reinterpret_cast<LARGE_INTEGER*>(&freq) );
-		frequency = (float)freq;
+		frequency = (double)freq;
 	}
 
 	return frequency;
 }
 
-float GetSystemClockTime()
+double GetSystemClockTime()
 {
 	unsigned __int64 counter;
 	QueryPerformanceCounter( reinterpret_cast<LARGE_INTEGER*>(&counter) );
-	return (float)counter;
+	return (double)counter;
 }
 
-float SystemTimeToMs(float sysTime)
+double SystemTimeToMs(double sysTime)
 {
-	return (float)sysTime * 1000 / GetSystemClockFrequency();
+	return sysTime * 1000 / GetSystemClockFrequency();
 }
 
 /**
  * Determines the current system time in milliseconds.
  */
-float GetSystemTimeMs()
+double GetSystemTimeMs()
 {
 	return SystemTimeToMs( GetSystemClockTime() );
 }
@@ -400,7 +400,7 @@ int APIENTRY _tWinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPTSTR lpCm
 		}
 
 		// Record the frame time
-		float curTime = GetSystemTimeMs();
+		double curTime = GetSystemTimeMs();
 
 		// Begin streaming when ready
 		if (gStreamingDesired && 
@@ -415,14 +415,24 @@ int APIENTRY _tWinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPTSTR lpCm
 		// If you send frames too quickly to the SDK (based on the broadcast FPS you configured) it will not be able 
 		// to make use of them all.  In that case, it will simply release buffers without using them which means the
 		// game wasted time doing the capture.  To mitigate this, the app should pace the captures to the broadcast FPS.
-		float captureDelta = curTime - gLastCaptureTime;
-		bool isTimeForNextCapture = (captureDelta / 1000.0f) >= (1.0f / gBroadcastFramesPerSecond);
+		double capturePeriod = 1000.0 / gBroadcastFramesPerSecond;
+		double captureDelta = curTime - gLastCaptureTime;
+		bool isTimeForNextCapture = captureDelta >= capturePeriod;
 
 		// streaming is in progress so try and capture a frame
 		if (IsStreaming() && 
 			!gPaused &&
 			isTimeForNextCapture)
 		{
+			// Advance the capture time by exactly one frame period so captures stay on a steady grid at the broadcast
+			// FPS instead of drifting later with every rendered frame.  If the game hitched and fell more than a frame
+			// behind then resynchronize rather than capturing a burst of frames to catch up.
+			gLastCaptureTime += capturePeriod;
+			if (curTime - gLastCaptureTime >= capturePeriod)
+			{
+				gLastCaptureTime = curTime;
+			}
+
 			// capture a snapshot of the back buffer
 			unsigned char* pBgraFrame = nullptr;
 			int width = 0;
@@ -481,7 +491,7 @@ int APIENTRY _tWinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPTSTR lpCm
 		#undef CHAT_STATE
 
 		char buffer[256];
-		sprintf_s(buffer, sizeof(buffer), "Twitch Direct3D Integration Sample - %s - Stream:%s Chat:%s", GetUsername().c_str(), streamStates[GetStreamState()], chatStates[GetChatState()]);
+		sprintf_s(buffer, sizeof(buffer), "Twitch Direct3D Integration Sample - %s - Stream:%s Chat:%s    Starved=%u Dropped=%u Reconnects=%u LastOutage=%llums LastStop=%llums", GetUsername().c_str(), streamStates[GetStreamState()], chatStates[GetChatState()], GetStarvedCaptureCount(), GetDroppedFrameCount(), GetReconnectCount(), (unsigned long long)GetLastOutageDurationMs(), (unsigned long long)GetLastStopDurationMs());
 		SetWindowTextA(gWindowHandle, buffer);
 	}
 
@@ -662,9 +672,11 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
 					// Toggle streaming
 					case VK_F5:
 					{
-						if (IsStreaming())
+						// Test the desired state rather than IsStreaming() so the toggle still turns streaming off during a reconnect backoff
+						if (gStreamingDesired)
 						{
 							gStreamingDesired = false;
+							CancelReconnect();
 							StopStreaming();
 						}
 						else
@@ -684,11 +696,9 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
 					// Toggle broadcast resolution
 					case VK_F1:
 					{
-						bool streaming = IsStreaming();
-						if (streaming)
-						{
-							StopStreaming();
-						}
+						// The stop finishes asynchronously.  gStreamingDesired is still set so the main loop restarts the stream at the
+						// new resolution once the SDK is ready again.
+						StopStreaming();
 
 						if (gBroadcastWidth == 640)
 						{
@@ -701,11 +711,6 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
 							gBroadcastHeight = 368;
 						}
 
-						if (streaming)
-						{
-							StartStreaming(gBroadcastWidth, gBroadcastHeight, gBroadcastFramesPerSecond);
-						}
-
 						break;
 					}
 				}
@@ -21,4 +21,4 @@
 #include <string>
 
 void ReportError(const char* format, ...);
-float GetSystemTimeMs();
+double GetSystemTimeMs();
@@ -28,7 +28,7 @@ FLOAT gWorldSize = 0;
 unsigned int gVertexDim = 0;
 unsigned int gNumVertices = 0;
 unsigned int gNumIndices = 0;
-float gWaveStartTime = 0;
+double gWaveStartTime = 0;
 
 
 /**
@@ -178,7 +178,7 @@ void UpdateWaveMesh()
 	// This is a horrible way to animate the mesh and it should be done in a simple vertex shader.  However, it's a simple
 	// sample and this keeps things simpler.
 
-	float totalTime = GetSystemTimeMs() - gWaveStartTime;
+	float totalTime = static_cast<float>(GetSystemTimeMs() - gWaveStartTime);
 
 	const float amp = 3.0f;
 	const float freq = 2;
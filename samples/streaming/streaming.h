@@ -22,7 +22,8 @@
 	STREAM_STATE(FoundIngestServer)\
 	STREAM_STATE(ReadyToStream)\
 	STREAM_STATE(Streaming)\
-	STREAM_STATE(Paused)
+	STREAM_STATE(Paused)\
+	STREAM_STATE(Stopping)
 
 
 #undef STREAM_STATE
@@ -37,13 +38,19 @@ void InitializeStreaming(const std::string& username, const std::string& passwor
 void StartStreaming(unsigned int outputWidth, unsigned int outputHeight, unsigned int targetFps, TTV_PixelFormat pixelFormat);
 const std::string& GetUsername();
 unsigned char* GetNextFreeBuffer();
+unsigned int GetStarvedCaptureCount();
+unsigned int GetDroppedFrameCount();
 void SubmitFrame(unsigned char* pBgraFrame);
 void Pause();
 StreamState GetStreamState();
 bool IsStreaming();
 bool IsReadyToStream();
+unsigned int GetReconnectCount();
+uint64_t GetLastOutageDurationMs();
+void CancelReconnect();
 void FlushStreamingEvents();
 void StopStreaming();
+uint64_t GetLastStopDurationMs();
 void ShutdownStreaming();
 void RunCommercial();
 
@@ -231,7 +231,7 @@ bool CaptureFrame_Fast(int captureWidth, int captureHeight, unsigned char*& outB
 	if (gMainRenderTargetSurface == nullptr || 
 		captureWidth <= 0 || 
 		captureHeight <= 0 ||
-		captureWidth % 16 != 0 ||
+		captureWidth % 32 != 0 ||
 		captureHeight % 16 != 0)
 	{
 		return false;
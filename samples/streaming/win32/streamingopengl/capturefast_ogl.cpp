@@ -262,6 +262,12 @@ static void CreateResizeFBO( int captureWidth, int captureHeight )
 
 	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, gResizeTexture, 0);		
 
+	// Clear to black once.  Each capture only overwrites the destination rectangle so the black borders persist.
+	glPushAttrib(GL_COLOR_BUFFER_BIT);
+	glClearColor(0,0,0,0);
+	glClear(GL_COLOR_BUFFER_BIT);
+	glPopAttrib();
+
 	glBindFramebuffer(GL_FRAMEBUFFER, 0);
 }
 
@@ -320,75 +326,17 @@ static void CaptureFrame( int captureWidth, int captureHeight )
 		destRect.right = (int)( ((float)captureWidth + (float)gWindowWidth*scale) / 2 );
 	}
 
-	// render to resize FBO
-    glBindFramebuffer(GL_FRAMEBUFFER, gResizeFBO);
-	
-	// push viewport & clear color
-	glPushAttrib(GL_VIEWPORT_BIT | GL_COLOR_BUFFER_BIT);
-
-	glClearColor(0,0,0,0);
-	glClear(GL_COLOR_BUFFER_BIT);
-	
-	// set viewport to dest rect
-	glViewport( destRect.left, destRect.top, 
-				destRect.right - destRect.left + 1, 
-				destRect.bottom - destRect.top + 1);
-
-    // invert texcoord because opengl's backbuffer starts from bottom
-                          /*pos*/  /*texcoord*/
-	const float quad[] = { 0,1,    0,0,
-	                       0,0,    0,1,
-	                       1,1,    1,0,
-	                       1,0,    1,1 };
-
-	glDepthMask(false);
-	glDisable(GL_DEPTH_TEST);
-	glDisable(GL_ALPHA_TEST);
-	glDisable(GL_BLEND);
+	// Flip, stretch and black-border the scene into the resize FBO with a single blit.  The destination Y coordinates
+	// are swapped to invert the image because opengl's backbuffer starts from bottom.
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, gSceneFBO);
+	glBindFramebuffer(GL_DRAW_FRAMEBUFFER, gResizeFBO);
 
-	// setup matrix
-	{
-		// set modeview to identity
-		glPushMatrix();
-		glLoadIdentity();
+	glBlitFramebuffer( 0, 0, gWindowWidth, gWindowHeight,
+					   destRect.left, destRect.bottom + 1, destRect.right + 1, destRect.top,
+					   GL_COLOR_BUFFER_BIT, GL_NEAREST );
 
-		// set 2D projection
-		glMatrixMode(GL_PROJECTION);
-		glPushMatrix();
-		glLoadIdentity();
-		gluOrtho2D(0,1,0,1);
-	}
-		
-	glEnableClientState(GL_VERTEX_ARRAY);
-	glEnableClientState(GL_TEXTURE_COORD_ARRAY);
-
-	glEnable(GL_TEXTURE_2D);
-	glBindTexture(GL_TEXTURE_2D, gSceneTexture);
-
-	glVertexPointer(  2, GL_FLOAT, sizeof(float)*4, quad);
-	glTexCoordPointer(2, GL_FLOAT, sizeof(float)*4, quad+2);
-
-	glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
-
-	glBindTexture(GL_TEXTURE_2D, 0);
-
-	glDisableClientState(GL_VERTEX_ARRAY);
-	glDisableClientState(GL_TEXTURE_COORD_ARRAY);
-
-	glDepthMask(true);
-
-	// restore matrix
-	{
-		// restore projection
-		glPopMatrix();
-
-		// restore modelview
-	    glMatrixMode(GL_MODELVIEW);	
-		glPopMatrix();
-	}	
-
-	// restor viewport & clear color
-	glPopAttrib();
+	glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, gResizeFBO);
 
 
 	// asynchronously read resize FBO to capture PBO
@@ -482,7 +430,7 @@ bool CaptureFrame_Fast(int captureWidth, int captureHeight, unsigned char*& outR
 	if ( gSceneFBO == 0 || 
 		 captureWidth <= 0 || 
 		 captureHeight <= 0 ||
-		 captureWidth % 16 != 0 ||
+		 captureWidth % 32 != 0 ||
 		 captureHeight % 16 != 0)
 	{
 		return false;
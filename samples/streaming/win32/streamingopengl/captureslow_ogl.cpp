@@ -239,6 +239,12 @@ static void CreateResizeFBO( int captureWidth, int captureHeight )
 
 	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, gResizeTexture, 0);		
 
+	// Clear to black once.  Each capture only overwrites the destination rectangle so the black borders persist.
+	glPushAttrib(GL_COLOR_BUFFER_BIT);
+	glClearColor(0,0,0,0);
+	glClear(GL_COLOR_BUFFER_BIT);
+	glPopAttrib();
+
 	glBindFramebuffer(GL_FRAMEBUFFER, 0);
 }
 
@@ -291,77 +297,16 @@ static void RenderToResizeFBO( int captureWidth, int captureHeight )
 		destRect.right = (int)( ((float)captureWidth + (float)gWindowWidth*scale) / 2 );
 	}
 
-	// render to resize FBO
-    glBindFramebuffer(GL_FRAMEBUFFER, gResizeFBO);
-	
-	// push viewport & clear color
-	glPushAttrib(GL_VIEWPORT_BIT | GL_COLOR_BUFFER_BIT);
-
-	glClearColor(0,0,0,0);
-	glClear(GL_COLOR_BUFFER_BIT);
-	
-	// set viewport to dest rect
-	glViewport( destRect.left, destRect.top, 
-				destRect.right - destRect.left + 1, 
-				destRect.bottom - destRect.top + 1);	
-
-    // invert texcoord because opengl's backbuffer starts from bottom
-                          /*pos*/  /*texcoord*/
-	const float quad[] = { 0,1,    0,0,
-	                       0,0,    0,1,
-	                       1,1,    1,0,
-	                       1,0,    1,1 };
-
-	glDepthMask(false);
-	glDisable(GL_DEPTH_TEST);
-	glDisable(GL_ALPHA_TEST);
-	glDisable(GL_BLEND);
-
-	// setup matrix
-	{
-		// set modeview to identity
-		glPushMatrix();
-		glLoadIdentity();
-
-		// set 2D projection
-		glMatrixMode(GL_PROJECTION);
-		glPushMatrix();
-		glLoadIdentity();
-		gluOrtho2D(0,1,0,1);
-	}
-		
-	glEnableClientState(GL_VERTEX_ARRAY);
-	glEnableClientState(GL_TEXTURE_COORD_ARRAY);
-
-	glEnable(GL_TEXTURE_2D);
-	glBindTexture(GL_TEXTURE_2D, gSceneTexture);
-
-	glVertexPointer(  2, GL_FLOAT, sizeof(float)*4, quad);
-	glTexCoordPointer(2, GL_FLOAT, sizeof(float)*4, quad+2);
-
-	glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
-
-	glBindTexture(GL_TEXTURE_2D, 0);
-
-	glDisableClientState(GL_VERTEX_ARRAY);
-	glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+	// Flip, stretch and black-border the scene into the resize FBO with a single blit.  The destination Y coordinates
+	// are swapped to invert the image because opengl's backbuffer starts from bottom.
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, gSceneFBO);
+	glBindFramebuffer(GL_DRAW_FRAMEBUFFER, gResizeFBO);
 
-	glDepthMask(true);
+	glBlitFramebuffer( 0, 0, gWindowWidth, gWindowHeight,
+					   destRect.left, destRect.bottom + 1, destRect.right + 1, destRect.top,
+					   GL_COLOR_BUFFER_BIT, GL_NEAREST );
 
 	glBindFramebuffer(GL_FRAMEBUFFER, 0);
-
-	// restore matrix
-	{
-		// restore projection
-		glPopMatrix();
-
-		// restore modelview
-	    glMatrixMode(GL_MODELVIEW);	
-		glPopMatrix();
-	}	
-
-	// restor viewport & clear color
-	glPopAttrib();
 }
 
 /**
@@ -45,7 +45,7 @@ char gWindowTitle[128];									// The title bar text
 
 float gRenderFramesPerSecond = 60;							// The number of frames per second to render, 0 if no throttling.
 unsigned __int64 gLastFrameTime = 0;						// The last time a frame was rendered.
-unsigned __int64 gLastCaptureTime = 0;									// The timestamp of the last frame capture.
+double gLastCaptureTime = 0;									// The scheduled time of the last frame capture in milliseconds.
 
 // 360p widescreen is 640x360
 // 480p widescreen is about 853x480
@@ -397,11 +397,9 @@ void KeyCallback(GLFWwindow* window, int key, int scancode, int action, int mods
 	{
 		case GLFW_KEY_F1:
 		{
-			bool streaming = IsStreaming();
-			if (streaming)
-			{
-				StopStreaming();
-			}
+			// The stop finishes asynchronously.  gStreamingDesired is still set so the main loop restarts the stream at the
+			// new resolution once the SDK is ready again.
+			StopStreaming();
 
 			if (gBroadcastWidth == 640)
 			{
@@ -413,19 +411,16 @@ void KeyCallback(GLFWwindow* window, int key, int scancode, int action, int mods
 				gBroadcastWidth = 640;
 				gBroadcastHeight = 368;
 			}
-
-			if (streaming)
-			{
-				StartStreaming(gBroadcastWidth, gBroadcastHeight, gBroadcastFramesPerSecond, TTV_PF_RGBA);
-			}
 			break;
 		}
 
 		case GLFW_KEY_F5:
 		{
-			if (IsStreaming())
+			// Test the desired state rather than IsStreaming() so the toggle still turns streaming off during a reconnect backoff
+			if (gStreamingDesired)
 			{
 				gStreamingDesired = false;
+				CancelReconnect();
 				StopStreaming();
 			}
 			else
@@ -548,14 +543,24 @@ int main(void)
 		// If you send frames too quickly to the SDK (based on the broadcast FPS you configured) it will not be able 
 		// to make use of them all.  In that case, it will simply release buffers without using them which means the
 		// game wasted time doing the capture.  To mitigate this, the app should pace the captures to the broadcast FPS.
-		unsigned __int64 captureDelta = curTime - gLastCaptureTime;
-		bool isTimeForNextCapture = (captureDelta / 1000.0) >= (1.0 / gBroadcastFramesPerSecond);
+		double capturePeriod = 1000.0 / gBroadcastFramesPerSecond;
+		double captureDelta = curTime - gLastCaptureTime;
+		bool isTimeForNextCapture = captureDelta >= capturePeriod;
 
 		// streaming is in progress so try and capture a frame
 		if (IsStreaming() && 
 			!gPaused &&
 			isTimeForNextCapture)
 		{
+			// Advance the capture time by exactly one frame period so captures stay on a steady grid at the broadcast
+			// FPS instead of drifting later with every rendered frame.  If the game hitched and fell more than a frame
+			// behind then resynchronize rather than capturing a burst of frames to catch up.
+			gLastCaptureTime += capturePeriod;
+			if (curTime - gLastCaptureTime >= capturePeriod)
+			{
+				gLastCaptureTime = curTime;
+			}
+
 			// capture a snapshot of the back buffer
 			unsigned char* pBgraFrame = nullptr;
 			int width = 0;
@@ -594,14 +599,14 @@ int main(void)
 		#undef STREAM_STATE
 		#define STREAM_STATE(__state__) #__state__,
 
-		char buffer[128];
+		char buffer[256];
 		const char* streamStates[] = 
 		{
 			STREAM_STATE_LIST
 		};
 		#undef STREAM_STATE
 
-		sprintf_s(buffer, sizeof(buffer), "Twitch OpenGL Streaming Sample - %s - %s    FPS=%d", GetUsername().c_str(), streamStates[GetStreamState()], fps);		
+		sprintf_s(buffer, sizeof(buffer), "Twitch OpenGL Streaming Sample - %s - %s    FPS=%d    Starved=%u Dropped=%u Reconnects=%u LastOutage=%llums LastStop=%llums", GetUsername().c_str(), streamStates[GetStreamState()], fps, GetStarvedCaptureCount(), GetDroppedFrameCount(), GetReconnectCount(), (unsigned long long)GetLastOutageDurationMs(), (unsigned long long)GetLastStopDurationMs());		
 		glfwSetWindowTitle(gWindow, buffer);		
 
 		// poll window events